@@ -4,11 +4,18 @@
 #include "hardware/i2c.h"
 #include "lib/ssd1306.h"
 #include "lib/font.h"
+#include "lib/filtro.h"
+#include "lib/periodico.h"
+#include "lib/governador.h"
+#include "lib/espelho.h"
 #include "hardware/pwm.h"
 #include "FreeRTOS.h"
 #include "task.h"
 #include "queue.h"
+#include "timers.h"
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include "hardware/clocks.h"
 #include <hardware/pio.h>
 #include "animacao_matriz.pio.h" // Biblioteca PIO para controle de LEDs WS2818B 
@@ -26,8 +33,32 @@
 
 #define MATRIZ_PIN 7            // Pino GPIO conectado aos LEDs WS2818B
 #define LED_COUNT 25            // Número de LEDs na matriz
-#define max_value_joy 4065.0 // (4081 - 16) que são os valores extremos máximos lidos pelo meu joystick
+#define max_value_joy 4065 // (4081 - 16) que são os valores extremos máximos lidos pelo meu joystick
+#define min_value_joy 16   // Menor valor lido pelo joystick
 #define BUZZER_A 21
+#define BUZZER_WRAP 1000        // Valor máximo do contador PWM do buzzer
+#define BUZZER_TOM_AGUDO_HZ 1000
+#define BUZZER_TOM_GRAVE_HZ 500
+#define I2C_BAUDRATE (400 * 1000)
+
+// Cadeia de filtros aplicada às leituras do ADC antes da avaliação do alerta
+#define FILTRO_ESTAGIOS (FILTRO_MEDIANA | FILTRO_IIR | FILTRO_DEADBAND)
+#define FILTRO_JANELA_MEDIANA 5 // Amostras na janela da mediana
+#define FILTRO_IIR_SHIFT 2      // Alfa do passa-baixa = 1/4
+#define FILTRO_DEADBAND_ADC 41  // Zona morta de ~1% da escala do joystick
+
+// Agendamento periódico por prazo absoluto
+#define TAXA_AMOSTRAGEM_HZ 10        // Taxa inicial de leitura do joystick, ajustável pela serial (1 a 1000 Hz)
+#define PUBLICACAO_INTERVALO_MS 100  // Intervalo de envio dos dados para display e atuadores
+#define BUZZER_PASSO_MS 100          // Passo do padrão do buzzer (200 ms ligado, 100 ms desligado)
+#define RELATORIO_INTERVALO_MS 5000  // Intervalo dos relatórios na serial
+
+// 1: LED, matriz e buzzer executam como callbacks da tarefa de timers do FreeRTOS
+// 0: cada atuador tem sua própria tarefa e fila
+#define MODO_ATUADORES_TIMER 1
+#define ATUADOR_STACK_SIZE 256   // Pilha (em palavras) de cada tarefa de atuador no modo com tarefas
+#define FILA_ALERTA_TAMANHO 5    // Tamanho das filas de alerta do LED e da matriz
+#define FILA_BUZZER_TAMANHO 3
 
 
 // Declaração de variáveis globais
@@ -62,6 +93,8 @@ uint32_t matrix_rgb(unsigned r, unsigned g, unsigned b){
 // Rotina para desenhar o padrão de LED
 void display_desenho(uint8_t desenho){
     uint32_t valor_led;
+    uint32_t quadro[LED_COUNT]; // Palavras na ordem de envio para o hardware
+    uint32_t cores[LED_COUNT]; // Cores em ordem de linha, para o espelho na serial USB
     for (int i = 0; i < LED_COUNT; i++){
         // Define a cor do LED de acordo com o padrão
         if (padrao_led[desenho][ordem[24 - i]] == 1){
@@ -71,24 +104,295 @@ void display_desenho(uint8_t desenho){
         } else{
             valor_led = matrix_rgb(0, 0, 0); // Desliga o LED
         }
+        quadro[i] = valor_led;
+        cores[ordem[24 - i]] = valor_led;
+    }
+
+    // Envia o quadro inteiro com o agendador suspenso: assim uma troca de clk_sys, feita
+    // pela tarefa do display, nunca acontece no meio do quadro
+    vTaskSuspendAll();
+    for (int i = 0; i < LED_COUNT; i++){
         // Atualiza o LED
-        pio_sm_put_blocking(pio, sm, valor_led);
+        pio_sm_put_blocking(pio, sm, quadro[i]);
+    }
+    xTaskResumeAll();
+    espelho_matriz(cores);
+}
+
+// Espera a matriz terminar de transmitir antes de uma troca de clk_sys. Como os quadros são
+// enviados com o agendador suspenso, o que resta na FIFO é sempre o fim de um quadro completo.
+void matriz_preparar_clock(void){
+    while (!pio_sm_is_tx_fifo_empty(pio, sm));
+    busy_wait_us(40); // Tempo para o último LED (24 bits a 800 kHz) sair do registrador de deslocamento
+}
+
+void matriz_ajustar_clock(uint32_t clk_hz){
+    pio_sm_set_clkdiv(pio, sm, animacao_matriz_clkdiv());
+}
+
+// Frequência atual do buzzer (0 = em silêncio), usada para refazer o divisor quando clk_sys muda
+uint buzzer_slice;
+volatile uint32_t buzzer_freq_hz = 0;
+
+// Configura o divisor do PWM para gerar a frequência desejada com o clk_sys atual
+void buzzer_aplicar_divisor(uint32_t clk_hz, uint32_t freq_hz){
+    uint32_t div16 = ((uint64_t)clk_hz * 16) / ((uint64_t)freq_hz * BUZZER_WRAP); // Divisor em ponto fixo 8.4
+    pwm_set_clkdiv_int_frac(buzzer_slice, div16 >> 4, div16 & 0xF);
+}
+
+void buzzer_tocar(uint32_t freq_hz){
+    taskENTER_CRITICAL(); // Evita calcular o divisor com um clk_sys que está sendo trocado
+    buzzer_freq_hz = freq_hz;
+    if (freq_hz){
+        buzzer_aplicar_divisor(clock_get_hz(clk_sys), freq_hz);
+        pwm_set_gpio_level(BUZZER_A, 100);
+    } else{
+        pwm_set_gpio_level(BUZZER_A, 0);
+    }
+    taskEXIT_CRITICAL();
+}
+
+void buzzer_ajustar_clock(uint32_t clk_hz){
+    if (buzzer_freq_hz){
+        buzzer_aplicar_divisor(clk_hz, buzzer_freq_hz);
     }
 }
 
+void display_ajustar_clock(uint32_t clk_hz){
+    i2c_set_baudrate(I2C_PORT, I2C_BAUDRATE);
+}
+
+void led_init(void){
+    gpio_init(LED_RED);
+    gpio_set_dir(LED_RED, GPIO_OUT);
+}
+
+void led_atualizar(bool alerta){
+    if (alerta){
+        gpio_put(LED_RED, 1);
+    } else{
+        gpio_put(LED_RED, 0);
+    }
+}
+
+void matriz_init(void){
+    pio = pio0; 
+    uint offset = pio_add_program(pio, &animacao_matriz_program);
+    sm = pio_claim_unused_sm(pio, true);
+    animacao_matriz_program_init(pio, sm, offset, MATRIZ_PIN);
+
+    const governador_periferico_t periferico_matriz = {
+        .preparar = matriz_preparar_clock,
+        .ajustar = matriz_ajustar_clock,
+    };
+    governador_registrar(&periferico_matriz);
+}
+
+void matriz_atualizar(bool alerta){
+    if (alerta){
+        // Liga com o padrão 0
+        display_desenho(0);
+    } else{
+        // Desliga
+        display_desenho(1);
+    }
+}
+
+void buzzer_init(void){
+    // Configuração do buzzer
+    gpio_set_function(BUZZER_A, GPIO_FUNC_PWM);
+    buzzer_slice = pwm_gpio_to_slice_num(BUZZER_A); // Obtém o slice correspondente
+    pwm_set_wrap(buzzer_slice, BUZZER_WRAP);  // Define o valor máximo do PWM
+    buzzer_tocar(0);
+    pwm_set_enabled(buzzer_slice, true);
+
+    const governador_periferico_t periferico_buzzer = { .ajustar = buzzer_ajustar_clock };
+    governador_registrar(&periferico_buzzer);
+}
+
+// Avança um passo de BUZZER_PASSO_MS do padrão de alerta: 0 e 1 com som, 2 em silêncio
+void buzzer_passo(bool alerta){
+    static bool som = false; // Para definir qual o som a ser tocado
+    static uint8_t passo = 0;
+
+    if (alerta && passo == 0){
+        buzzer_tocar(som ? BUZZER_TOM_AGUDO_HZ : BUZZER_TOM_GRAVE_HZ);
+        som = !som;
+    } else if (!alerta || passo == 2){
+        buzzer_tocar(0);
+    }
+
+    passo = alerta ? (passo + 1) % 3 : 0;
+}
+
+// Estatísticas das tarefas medidas. São impressas pela tarefa do display, para que a
+// escrita na serial USB não entre no atraso e nos prazos perdidos que estão sendo medidos.
+filtro_t filtro_nivel;
+filtro_t filtro_volume;
+periodico_t periodo_joystick;
+periodico_t periodo_buzzer;
+
+#if MODO_ATUADORES_TIMER
+TimerHandle_t xTimerBuzzer;
+TickType_t buzzer_prazo;     // Prazo absoluto da próxima expiração do timer do buzzer
+
+void vBuzzerTimerCallback(TimerHandle_t timer){
+    // O timer de auto-reload expira a cada BUZZER_PASSO_MS contados a partir do último xTimerReset
+    buzzer_prazo += pdMS_TO_TICKS(BUZZER_PASSO_MS);
+    periodico_registrar(&periodo_buzzer, buzzer_prazo);
+    buzzer_passo(true);
+}
+
+// Executada pela tarefa de timers sempre que o modo de alerta muda
+volatile bool alerta_atuadores = false;    // Último estado aplicado por completo aos atuadores
+volatile bool atuadores_pendente = false;  // Há uma atualização na fila da tarefa de timers
+
+void vAtuadoresAlertaCallback(void *params, uint32_t alerta){
+    BaseType_t aceito;
+
+    led_atualizar(alerta);
+    matriz_atualizar(alerta);
+    if (alerta){
+        buzzer_passo(true);
+        buzzer_prazo = xTaskGetTickCount();
+        aceito = xTimerReset(xTimerBuzzer, 0);
+    } else{
+        aceito = xTimerStop(xTimerBuzzer, 0);
+        buzzer_passo(false);
+    }
+
+    // Se o comando do timer do buzzer não coube na fila, o estado não é dado como aplicado
+    // e a tarefa do joystick reenvia a atualização na próxima amostra
+    if (aceito == pdPASS){
+        alerta_atuadores = alerta;
+    }
+    atuadores_pendente = false;
+}
+
+void atuadores_init(void){
+    led_init();
+    matriz_init();
+    buzzer_init();
+    matriz_atualizar(false);
+    periodico_init(&periodo_buzzer, 1000 / BUZZER_PASSO_MS);
+}
+#endif
+
 
 
 typedef struct
 {
     uint16_t volume;
     uint16_t nivel;
+    bool alerta;
 } data;
 
 QueueHandle_t xQueueJoystickConvert;
+#if !MODO_ATUADORES_TIMER
 QueueHandle_t bQueueLedAlerta;
 QueueHandle_t bQueueBuzzerAlerta;
 QueueHandle_t bQueueMatrizAlerta;
-QueueHandle_t bQueueDisplayAlerta;
+#endif
+
+// Tarefas que executam os atuadores: a tarefa de timers ou as tarefas de LED, matriz e buzzer
+TaskHandle_t tarefas_atuadores[3];
+uint8_t num_tarefas_atuadores = 0;
+
+volatile uint32_t contador_trocas_contexto = 0;
+volatile uint32_t contador_trocas_atuadores = 0;
+volatile uint32_t contador_ativacoes_evitadas = 0; // Ativações que as tarefas dedicadas teriam tido no modo timer
+
+// Chamada pelo traceTASK_SWITCHED_IN definido em FreeRTOSConfig.h
+void registrar_troca_contexto(void){
+    TaskHandle_t atual = xTaskGetCurrentTaskHandle();
+
+    contador_trocas_contexto++;
+    for (uint8_t i = 0; i < num_tarefas_atuadores; i++){
+        if (tarefas_atuadores[i] == atual){
+            contador_trocas_atuadores++;
+            break;
+        }
+    }
+}
+
+uint32_t heap_usado = 0; // Heap ocupado pelas tarefas, filas e timers criados em main()
+
+// RAM que o modo timer deixa de alocar no heap_4: pilhas e TCBs das três tarefas de atuador
+// e as três filas de alerta, descontando o timer do buzzer. Cada alocação do heap_4 tem um
+// cabeçalho de 8 bytes; tarefas fazem duas alocações (pilha e TCB) e filas, uma.
+#define HEAP_CABECALHO 8
+#define RAM_TAREFAS_ATUADORES (3 * (ATUADOR_STACK_SIZE * sizeof(StackType_t) + sizeof(StaticTask_t) + 2 * HEAP_CABECALHO))
+#define RAM_FILAS_ATUADORES (3 * (sizeof(StaticQueue_t) + HEAP_CABECALHO) + (2 * FILA_ALERTA_TAMANHO + FILA_BUZZER_TAMANHO) * sizeof(bool))
+#define RAM_TIMER_BUZZER (sizeof(StaticTimer_t) + HEAP_CABECALHO)
+#define RAM_ECONOMIA_TIMER (RAM_TAREFAS_ATUADORES + RAM_FILAS_ATUADORES - RAM_TIMER_BUZZER)
+
+// Imprime a memória usada pelo RTOS e a taxa de trocas de contexto desde o último relatório
+void sistema_relatorio(void){
+    static uint32_t trocas_anterior = 0;
+    static uint32_t trocas_atuadores_anterior = 0;
+    static uint64_t instante_anterior = 0;
+
+    uint64_t agora = time_us_64();
+    uint64_t intervalo = agora - instante_anterior;
+    uint32_t trocas = contador_trocas_contexto;
+    uint32_t trocas_atuadores = contador_trocas_atuadores;
+    uint32_t trocas_por_s = ((uint64_t)(trocas - trocas_anterior) * 1000000) / intervalo;
+    uint32_t atuadores_por_s = ((uint64_t)(trocas_atuadores - trocas_atuadores_anterior) * 1000000) / intervalo;
+    trocas_anterior = trocas;
+    trocas_atuadores_anterior = trocas_atuadores;
+    instante_anterior = agora;
+
+    printf("[sistema] atuadores: %s | tarefas: %lu | heap usado: %lu bytes | trocas de contexto: %lu/s, dos atuadores: %lu/s\n",
+           MODO_ATUADORES_TIMER ? "timers" : "tarefas", (unsigned long)uxTaskGetNumberOfTasks(),
+           (unsigned long)heap_usado, (unsigned long)trocas_por_s, (unsigned long)atuadores_por_s);
+#if MODO_ATUADORES_TIMER
+    static uint32_t evitadas_anterior = 0;
+    uint32_t evitadas = contador_ativacoes_evitadas;
+    // Somadas às ativações periódicas que a tarefa do buzzer teria a cada BUZZER_PASSO_MS
+    uint32_t evitadas_por_s = ((uint64_t)(evitadas - evitadas_anterior) * 1000000) / intervalo + 1000 / BUZZER_PASSO_MS;
+    evitadas_anterior = evitadas;
+
+    // Cada ativação de uma tarefa dedicada custaria ao menos uma troca de contexto para ela
+    printf("[sistema] economia do modo timer: %lu bytes de RAM | com tarefas dedicadas os atuadores teriam %lu ativacoes/s\n",
+           (unsigned long)RAM_ECONOMIA_TIMER, (unsigned long)evitadas_por_s);
+#endif
+}
+
+// Converte a leitura do ADC para a faixa de 0 a 100 usando apenas aritmética inteira
+uint16_t converte_percentual(uint16_t leitura){
+    if (leitura <= min_value_joy){
+        return 0;
+    }
+    uint32_t percentual = ((uint32_t)(leitura - min_value_joy) * 100) / max_value_joy;
+    return percentual > 100 ? 100 : percentual;
+}
+
+// Lê da serial, sem bloquear, os comandos "taxa <hz>" (taxa de amostragem)
+// e "espelho <0|1>" (espelho do display e da matriz na serial USB)
+void ler_comando(periodico_t *periodo){
+    static char comando[16];
+    static uint8_t tamanho = 0;
+    int c;
+
+    while ((c = getchar_timeout_us(0)) != PICO_ERROR_TIMEOUT){
+        if (c != '\n' && c != '\r'){
+            if (tamanho < sizeof(comando) - 1){
+                comando[tamanho++] = c;
+            }
+            continue;
+        }
+        comando[tamanho] = '\0';
+        tamanho = 0;
+
+        // strncmp + strtoul em vez de sscanf, que usa centenas de bytes da pilha da tarefa
+        if (strncmp(comando, "taxa ", 5) == 0){
+            periodico_set_freq(periodo, strtoul(comando + 5, NULL, 10));
+            printf("Taxa de amostragem: %lu Hz\n", (unsigned long)periodo->freq_hz);
+        } else if (strncmp(comando, "espelho ", 8) == 0){
+            espelho_habilitar(strtoul(comando + 8, NULL, 10) != 0);
+        }
+    }
+}
 
 void vJoystickTask(void *params)
 {
@@ -96,20 +400,36 @@ void vJoystickTask(void *params)
     adc_gpio_init(ADC_JOYSTICK_X);
     adc_init();
 
+    const filtro_config_t config_filtro = {
+        .estagios = FILTRO_ESTAGIOS,
+        .mediana_n = FILTRO_JANELA_MEDIANA,
+        .iir_shift = FILTRO_IIR_SHIFT,
+        .deadband = FILTRO_DEADBAND_ADC,
+    };
+    filtro_init(&filtro_nivel, &config_filtro);
+    filtro_init(&filtro_volume, &config_filtro);
+
+#if MODO_ATUADORES_TIMER
+    atuadores_init();
+    tarefas_atuadores[num_tarefas_atuadores++] = xTimerGetTimerDaemonTaskHandle();
+#endif
+
     data joydata;
     bool alerta;
+    bool alerta_anterior = false;
+    absolute_time_t proxima_publicacao = get_absolute_time();
+
+    periodico_init(&periodo_joystick, TAXA_AMOSTRAGEM_HZ);
 
     while (true)
     {
         adc_select_input(0); // GPIO 26 = ADC0
-        joydata.nivel = adc_read();
-        joydata.nivel = ((joydata.nivel - 16) / max_value_joy) * 100; // Converte o valor do eixo y para a faixa de 0 a 100
+        joydata.nivel = filtro_processar(&filtro_nivel, adc_read());
+        joydata.nivel = converte_percentual(joydata.nivel); // Converte o valor do eixo y para a faixa de 0 a 100
 
         adc_select_input(1); // GPIO 27 = ADC1
-        joydata.volume = adc_read();
-        joydata.volume = ((joydata.volume - 16) / max_value_joy) * 100; // Converte o valor do eixo x para a faixa de 0 a 100
-        
-        xQueueSend(xQueueJoystickConvert, &joydata, 0); // Envia o valor do joystick para a fila
+        joydata.volume = filtro_processar(&filtro_volume, adc_read());
+        joydata.volume = converte_percentual(joydata.volume); // Converte o valor do eixo x para a faixa de 0 a 100
 
         // Verifica se os limites estão acima
         if (joydata.nivel > 70 || joydata.volume > 80){
@@ -117,19 +437,52 @@ void vJoystickTask(void *params)
         } else{
             alerta = false;
         }
+        joydata.alerta = alerta;
+
+#if MODO_ATUADORES_TIMER
+        // Até o estado ser aplicado por completo (fila da tarefa de timers ou do timer do buzzer
+        // cheia), tenta de novo a cada amostra
+        if (!atuadores_pendente && alerta != alerta_atuadores){
+            // Marcado antes do envio: a tarefa de timers tem prioridade maior e pode executar
+            // o callback antes de xTimerPendFunctionCall retornar
+            atuadores_pendente = true;
+            if (xTimerPendFunctionCall(vAtuadoresAlertaCallback, NULL, alerta, 0) != pdPASS){
+                atuadores_pendente = false;
+            }
+        }
+#endif
+
+        // Os consumidores recebem dados a 10 Hz independentemente da taxa de amostragem,
+        // mas uma mudança no alerta é publicada imediatamente
+        if (alerta != alerta_anterior || time_reached(proxima_publicacao)){
+            xQueueSend(xQueueJoystickConvert, &joydata, 0); // Envia o valor do joystick para a fila
+#if MODO_ATUADORES_TIMER
+            // LED e matriz: uma ativação por publicação nas tarefas dedicadas
+            contador_ativacoes_evitadas += 2;
+#else
+            xQueueSend(bQueueLedAlerta, &alerta, 0);
+            xQueueSend(bQueueBuzzerAlerta, &alerta, 0);
+            xQueueSend(bQueueMatrizAlerta, &alerta, 0);
+#endif
+
+            alerta_anterior = alerta;
+            // Avança o prazo a partir dele mesmo, para manter os 10 Hz sem deriva;
+            // se ficou para trás (ex.: taxa de amostragem baixa), recomeça a partir de agora
+            proxima_publicacao = delayed_by_ms(proxima_publicacao, PUBLICACAO_INTERVALO_MS);
+            if (time_reached(proxima_publicacao)){
+                proxima_publicacao = make_timeout_time_ms(PUBLICACAO_INTERVALO_MS);
+            }
 
-        xQueueSend(bQueueDisplayAlerta, &alerta, 0);
-        xQueueSend(bQueueLedAlerta, &alerta, 0);
-        xQueueSend(bQueueBuzzerAlerta, &alerta, 0);
-        xQueueSend(bQueueMatrizAlerta, &alerta, 0);
+            ler_comando(&periodo_joystick);
+        }
 
-        vTaskDelay(pdMS_TO_TICKS(100));              // 10 Hz de leitura
+        periodico_aguardar(&periodo_joystick); // Aguarda o próximo prazo absoluto, sem acumular deriva
     }
 }
 
 void vDisplayTask(void *params)
 {
-    i2c_init(I2C_PORT, 400 * 1000);
+    i2c_init(I2C_PORT, I2C_BAUDRATE);
     gpio_set_function(I2C_SDA, GPIO_FUNC_I2C);
     gpio_set_function(I2C_SCL, GPIO_FUNC_I2C);
     gpio_pull_up(I2C_SDA);
@@ -140,8 +493,12 @@ void vDisplayTask(void *params)
     ssd1306_config(&ssd);
     ssd1306_send_data(&ssd);
 
+    // O display é o único usuário do I2C, então as trocas de clk_sys são feitas aqui, entre quadros
+    const governador_periferico_t periferico_display = { .ajustar = display_ajustar_clock };
+    governador_registrar(&periferico_display);
+    absolute_time_t proximo_relatorio = make_timeout_time_ms(RELATORIO_INTERVALO_MS);
+
     data joydata;
-    bool alerta = false;
     bool cor = true;
     while (true)
     {
@@ -151,109 +508,89 @@ void vDisplayTask(void *params)
             char vol[20];
             char nivel[20];
             char modo[20];
-            if(xQueueReceive(bQueueDisplayAlerta, &alerta, portMAX_DELAY) == pdTRUE){
-                sprintf(vol, "V. chuva: %d%%", joydata.volume);
-                sprintf(nivel, "N.  agua: %d%%", joydata.nivel);
-                sprintf(modo, "Modo: %s", alerta ? "ALERTA!!" : "Normal");
-                if (alerta){
-                    cor = !cor;
-
-                    ssd1306_fill(&ssd, cor);                        // Limpa a tela
-                    ssd1306_rect(&ssd, 3, 3, 122, 58, !cor, cor); // Desenha um retângulo
-                    ssd1306_draw_string(&ssd, vol, 8, 10); // Desenha uma string
-                    ssd1306_draw_string(&ssd, nivel, 8, 20); // Desenha uma string
-                    ssd1306_line(&ssd, 0, 32, 127, 32, true); // Desenha uma linha divisória no meio da tela
-                    ssd1306_draw_string(&ssd, modo, 8, 40); // Desenha uma string
-                    ssd1306_send_data(&ssd);
-                } else{
-                    ssd1306_fill(&ssd, true);                        // Limpa a tela
-                    ssd1306_rect(&ssd, 3, 3, 122, 58, false, true); // Desenha um retângulo
-                    ssd1306_draw_string(&ssd, vol, 8, 10); // Desenha uma string
-                    ssd1306_draw_string(&ssd, nivel, 8, 20); // Desenha uma string
-                    ssd1306_line(&ssd, 0, 32, 127, 32, true); // Desenha uma linha divisória no meio da tela
-                    ssd1306_draw_string(&ssd, modo, 8, 40); // Desenha uma string
-                    ssd1306_send_data(&ssd);
-                }
-            } 
+            bool alerta = joydata.alerta;
+
+            governador_set_alerta(alerta);
+            if (time_reached(proximo_relatorio)){
+                filtro_relatorio(&filtro_nivel, "nivel");
+                filtro_relatorio(&filtro_volume, "volume");
+                periodico_relatorio(&periodo_joystick, "joystick");
+                periodico_relatorio(&periodo_buzzer, MODO_ATUADORES_TIMER ? "buzzer (timer)" : "buzzer");
+                sistema_relatorio();
+                governador_relatorio();
+                espelho_relatorio();
+                proximo_relatorio = make_timeout_time_ms(RELATORIO_INTERVALO_MS);
+            }
+
+            sprintf(vol, "V. chuva: %d%%", joydata.volume);
+            sprintf(nivel, "N.  agua: %d%%", joydata.nivel);
+            sprintf(modo, "Modo: %s", alerta ? "ALERTA!!" : "Normal");
+            if (alerta){
+                cor = !cor;
+
+                ssd1306_fill(&ssd, cor);                        // Limpa a tela
+                ssd1306_rect(&ssd, 3, 3, 122, 58, !cor, cor); // Desenha um retângulo
+                ssd1306_draw_string(&ssd, vol, 8, 10); // Desenha uma string
+                ssd1306_draw_string(&ssd, nivel, 8, 20); // Desenha uma string
+                ssd1306_line(&ssd, 0, 32, 127, 32, true); // Desenha uma linha divisória no meio da tela
+                ssd1306_draw_string(&ssd, modo, 8, 40); // Desenha uma string
+                ssd1306_send_data(&ssd);
+            } else{
+                ssd1306_fill(&ssd, true);                        // Limpa a tela
+                ssd1306_rect(&ssd, 3, 3, 122, 58, false, true); // Desenha um retângulo
+                ssd1306_draw_string(&ssd, vol, 8, 10); // Desenha uma string
+                ssd1306_draw_string(&ssd, nivel, 8, 20); // Desenha uma string
+                ssd1306_line(&ssd, 0, 32, 127, 32, true); // Desenha uma linha divisória no meio da tela
+                ssd1306_draw_string(&ssd, modo, 8, 40); // Desenha uma string
+                ssd1306_send_data(&ssd);
+            }
+            espelho_display(&ssd);
         }
     }
 }
 
 
+#if !MODO_ATUADORES_TIMER
 void vLedTask(void *params)
 {
-    gpio_init(LED_RED);
-    gpio_set_dir(LED_RED, GPIO_OUT);
+    led_init();
 
     bool alerta;
     while (true){
         if (xQueueReceive(bQueueLedAlerta, &alerta, portMAX_DELAY) == pdTRUE){
-            if (alerta){
-                gpio_put(LED_RED, 1);
-            } else{
-                gpio_put(LED_RED, 0);
-            }
+            led_atualizar(alerta);
         }
-        vTaskDelay(pdMS_TO_TICKS(100));
     }
 }
 
 void vMatrizTask(void *params){
-    pio = pio0; 
-    uint offset = pio_add_program(pio, &animacao_matriz_program);
-    sm = pio_claim_unused_sm(pio, true);
-    animacao_matriz_program_init(pio, sm, offset, MATRIZ_PIN);
+    matriz_init();
 
     bool alerta;
 
     while (true){
         if (xQueueReceive(bQueueMatrizAlerta, &alerta, portMAX_DELAY) == pdTRUE){
-            if (alerta){
-                // Liga com o padrão 0
-                display_desenho(0);
-            } else{
-                // Desliga
-                display_desenho(1);
-            }
+            matriz_atualizar(alerta);
         }
-
-        // Lógica para atualizar a matriz de LEDs
-        vTaskDelay(pdMS_TO_TICKS(100));
     }
 }
 
 void vBuzzerTask(void *params){
-    // Configuração do buzzer
-    gpio_set_function(BUZZER_A, GPIO_FUNC_PWM);
-    uint slice_num = pwm_gpio_to_slice_num(BUZZER_A); // Obtém o slice correspondente
-    pwm_set_clkdiv(slice_num, 125); // Define o divisor de clock
-    pwm_set_wrap(slice_num, 1000);  // Define o valor máximo do PWM
-    pwm_set_enabled(slice_num, true);
+    buzzer_init();
     
-    bool alerta;
-    bool som = false; // Para definir qual o som a ser tocado
+    bool alerta = false;
+
+    periodico_init(&periodo_buzzer, 1000 / BUZZER_PASSO_MS);
+
     while (true){
-        if (xQueueReceive(bQueueBuzzerAlerta, &alerta, portMAX_DELAY) == pdTRUE){
-            if (alerta){
-                if (som){
-                    pwm_set_clkdiv(slice_num, 125); // Define o divisor de clock
-                    pwm_set_wrap(slice_num, 1000);  // Define o valor máximo do PWM
-                    pwm_set_gpio_level(BUZZER_A, 100);
-                    vTaskDelay(pdMS_TO_TICKS(200));
-                    som = !som;
-                } else{
-                    pwm_set_clkdiv(slice_num, 250); // Define o divisor de clock
-                    pwm_set_wrap(slice_num, 1000);  // Define o valor máximo do PWM
-                    pwm_set_gpio_level(BUZZER_A, 100);
-                    vTaskDelay(pdMS_TO_TICKS(200));
-                    som = !som;
-                }
-            }
-            pwm_set_gpio_level(BUZZER_A, 0);
-            vTaskDelay(pdMS_TO_TICKS(100));
-        }
+        // Consome a fila sem bloquear, ficando com o estado de alerta mais recente
+        while (xQueueReceive(bQueueBuzzerAlerta, &alerta, 0) == pdTRUE);
+
+        buzzer_passo(alerta);
+        periodico_aguardar(&periodo_buzzer);
     }
 }
+#endif
 
 
 int main()
@@ -262,17 +599,25 @@ int main()
 
     // Cria a fila para compartilhamento de valores
     xQueueJoystickConvert = xQueueCreate(5, sizeof(data));
-    bQueueDisplayAlerta = xQueueCreate(5, sizeof(bool));
-    bQueueLedAlerta = xQueueCreate(5, sizeof(bool));
-    bQueueBuzzerAlerta = xQueueCreate(3, sizeof(bool));
-    bQueueMatrizAlerta = xQueueCreate(5, sizeof(bool));
+#if !MODO_ATUADORES_TIMER
+    bQueueLedAlerta = xQueueCreate(FILA_ALERTA_TAMANHO, sizeof(bool));
+    bQueueBuzzerAlerta = xQueueCreate(FILA_BUZZER_TAMANHO, sizeof(bool));
+    bQueueMatrizAlerta = xQueueCreate(FILA_ALERTA_TAMANHO, sizeof(bool));
+#endif
 
     // Criação das tasks
-    xTaskCreate(vJoystickTask, "Joystick Task", 256, NULL, 1, NULL);
+    xTaskCreate(vJoystickTask, "Joystick Task", 512, NULL, 1, NULL); // Filtros, comandos da serial (printf) e inicialização dos atuadores
     xTaskCreate(vDisplayTask, "Display Task", 512, NULL, 1, NULL);
-    xTaskCreate(vLedTask, "LED Task", 256, NULL, 1, NULL);
-    xTaskCreate(vMatrizTask, "Matriz Task", 256, NULL, 1, NULL);
-    xTaskCreate(vBuzzerTask, "Buzzer Task", 256, NULL, 1, NULL);
+#if MODO_ATUADORES_TIMER
+    // LED e matriz são atualizados por xTimerPendFunctionCall; o buzzer usa um timer periódico
+    xTimerBuzzer = xTimerCreate("Buzzer Timer", pdMS_TO_TICKS(BUZZER_PASSO_MS), pdTRUE, NULL, vBuzzerTimerCallback);
+#else
+    xTaskCreate(vLedTask, "LED Task", ATUADOR_STACK_SIZE, NULL, 1, &tarefas_atuadores[0]);
+    xTaskCreate(vMatrizTask, "Matriz Task", ATUADOR_STACK_SIZE, NULL, 1, &tarefas_atuadores[1]);
+    xTaskCreate(vBuzzerTask, "Buzzer Task", ATUADOR_STACK_SIZE, NULL, 1, &tarefas_atuadores[2]);
+    num_tarefas_atuadores = 3;
+#endif
+    heap_usado = configTOTAL_HEAP_SIZE - xPortGetFreeHeapSize();
 
     // Inicia o agendador
     vTaskStartScheduler();
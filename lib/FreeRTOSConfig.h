@@ -44,7 +44,7 @@
  #define configUSE_PREEMPTION                    1
  #define configUSE_TICKLESS_IDLE                 0
  #define configUSE_IDLE_HOOK                     0
- #define configUSE_TICK_HOOK                     0
+ #define configUSE_TICK_HOOK                     1
  #define configTICK_RATE_HZ                      ( ( TickType_t ) 1000 )
  #define configMAX_PRIORITIES                    32
  #define configMINIMAL_STACK_SIZE                ( configSTACK_DEPTH_TYPE ) 256
@@ -128,11 +128,17 @@
  #define INCLUDE_xTaskGetIdleTaskHandle          1
  #define INCLUDE_eTaskGetState                   1
  #define INCLUDE_xTimerPendFunctionCall          1
+ #define INCLUDE_xTimerGetTimerDaemonTaskHandle  1
  #define INCLUDE_xTaskAbortDelay                 1
  #define INCLUDE_xTaskGetHandle                  1
  #define INCLUDE_xTaskResumeFromISR              1
  #define INCLUDE_xQueueGetMutexHolder            1
  
  /* A header file that defines trace macro can be included here. */
+ /* Conta as trocas de contexto para o relatório de desempenho da aplicação */
+ #ifndef __ASSEMBLER__
+ extern void registrar_troca_contexto(void);
+ #endif
+ #define traceTASK_SWITCHED_IN()                 registrar_troca_contexto()
  
  #endif /* FREERTOS_CONFIG_H */
\ No newline at end of file
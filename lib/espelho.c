@@ -0,0 +1,163 @@
+#include <stdio.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "espelho.h"
+
+/*
+ * Espelho do display e da matriz pela serial USB. Cada mensagem é uma linha de texto,
+ * para poder conviver com os relatórios impressos com printf:
+ *
+ *   $FK,<seq>,<pagina>,<rle>  página completa (quadro-chave)
+ *   $FD,<seq>,<pagina>,<rle>  XOR da página com o último quadro enviado
+ *   $FM,<rgb>                 cores dos 25 LEDs da matriz, em ordem de linha
+ *   $FE,<seq>                 fim do quadro
+ *
+ * <rle> são pares (repetições, valor) em hexadecimal e cada página tem um byte por coluna,
+ * com o bit 0 na linha de cima. Páginas sem mudança não são enviadas.
+ */
+
+#define ESPELHO_QUADRO_BYTES (WIDTH * HEIGHT / 8)
+#define ESPELHO_LINHA_MAX (24 + WIDTH * 4) // Cabeçalho + pior caso do RLE (um par por byte)
+
+static uint8_t ultimo_quadro[ESPELHO_QUADRO_BYTES]; // Último quadro enviado, página por página
+static uint32_t matriz_atual[ESPELHO_LEDS];
+static uint32_t ultima_matriz[ESPELHO_LEDS];
+static bool matriz_enviada = false;
+
+static volatile bool habilitado = false;
+static volatile bool forcar_keyframe = true;
+static uint32_t seq = 0;
+static uint32_t quadros_desde_keyframe = 0;
+
+static char linha[ESPELHO_LINHA_MAX];
+static const char hex[] = "0123456789ABCDEF";
+
+// Estatísticas desde o último relatório
+static uint32_t bytes_soma = 0;
+static uint32_t bytes_max = 0;
+static uint32_t quadros_enviados = 0;
+static uint32_t quadros_total = 0;
+
+void espelho_habilitar(bool ativo) {
+  forcar_keyframe = true;
+  habilitado = ativo;
+}
+
+// Guarda as cores da matriz (palavras GRB do WS2812, em ordem de linha) para o próximo quadro
+void espelho_matriz(const uint32_t *cores) {
+  taskENTER_CRITICAL();
+  memcpy(matriz_atual, cores, sizeof(matriz_atual));
+  taskEXIT_CRITICAL();
+}
+
+static size_t espelho_hex(size_t pos, uint8_t byte) {
+  linha[pos++] = hex[byte >> 4];
+  linha[pos++] = hex[byte & 0xF];
+  return pos;
+}
+
+static size_t espelho_rle(size_t pos, const uint8_t *dados, size_t tamanho) {
+  size_t i = 0;
+  while (i < tamanho) {
+    uint8_t valor = dados[i];
+    uint8_t repeticoes = 1;
+    while (i + repeticoes < tamanho && repeticoes < 255 && dados[i + repeticoes] == valor)
+      repeticoes++;
+    pos = espelho_hex(pos, repeticoes);
+    pos = espelho_hex(pos, valor);
+    i += repeticoes;
+  }
+  return pos;
+}
+
+// Envia a linha montada de uma só vez e sem conversão de '\n', retorna os bytes enviados
+static uint32_t espelho_enviar(size_t pos) {
+  linha[pos] = '\0';
+  puts_raw(linha);
+  return pos + 1;
+}
+
+static uint32_t espelho_enviar_matriz(void) {
+  uint32_t cores[ESPELHO_LEDS];
+
+  taskENTER_CRITICAL();
+  memcpy(cores, matriz_atual, sizeof(cores));
+  taskEXIT_CRITICAL();
+
+  if (matriz_enviada && memcmp(cores, ultima_matriz, sizeof(cores)) == 0)
+    return 0;
+  memcpy(ultima_matriz, cores, sizeof(cores));
+  matriz_enviada = true;
+
+  size_t pos = snprintf(linha, sizeof(linha), "$FM,");
+  for (uint8_t i = 0; i < ESPELHO_LEDS; ++i) {
+    pos = espelho_hex(pos, (cores[i] >> 16) & 0xFF); // R
+    pos = espelho_hex(pos, cores[i] >> 24);          // G
+    pos = espelho_hex(pos, (cores[i] >> 8) & 0xFF);  // B
+  }
+  return espelho_enviar(pos);
+}
+
+// Envia as mudanças do framebuffer desde o último quadro, deve ser chamada após ssd1306_send_data
+void espelho_display(const ssd1306_t *ssd) {
+  if (!habilitado)
+    return;
+
+  bool keyframe = forcar_keyframe || ++quadros_desde_keyframe >= ESPELHO_KEYFRAME_QUADROS;
+  if (keyframe) {
+    forcar_keyframe = false;
+    quadros_desde_keyframe = 0;
+    matriz_enviada = false;
+  }
+
+  uint8_t pagina[WIDTH];
+  uint32_t bytes = 0;
+  for (uint8_t p = 0; p < ssd->pages; ++p) {
+    uint8_t *anterior = &ultimo_quadro[p * ssd->width];
+    bool mudou = false;
+
+    // O buffer está em endereçamento vertical: um byte por página, coluna a coluna
+    for (uint8_t x = 0; x < ssd->width; ++x) {
+      uint8_t atual = ssd->ram_buffer[1 + x * ssd->pages + p];
+      pagina[x] = keyframe ? atual : atual ^ anterior[x];
+      mudou |= pagina[x] != 0;
+      anterior[x] = atual;
+    }
+    if (!keyframe && !mudou)
+      continue;
+
+    size_t pos = snprintf(linha, sizeof(linha), "$F%c,%lu,%u,", keyframe ? 'K' : 'D', (unsigned long)seq, p);
+    pos = espelho_rle(pos, pagina, ssd->width);
+    bytes += espelho_enviar(pos);
+  }
+  bytes += espelho_enviar_matriz();
+
+  quadros_total++;
+  if (bytes == 0)
+    return;
+
+  bytes += espelho_enviar(snprintf(linha, sizeof(linha), "$FE,%lu", (unsigned long)seq));
+  seq++;
+
+  bytes_soma += bytes;
+  if (bytes > bytes_max)
+    bytes_max = bytes;
+  quadros_enviados++;
+}
+
+// Imprime a banda usada pelo espelho e zera as estatísticas
+void espelho_relatorio(void) {
+  if (!habilitado)
+    return;
+
+  uint32_t media = quadros_total ? bytes_soma / quadros_total : 0;
+  printf("[espelho] quadros com mudanca: %lu de %lu | media: %lu bytes/quadro | max: %lu bytes\n",
+         (unsigned long)quadros_enviados, (unsigned long)quadros_total, (unsigned long)media, (unsigned long)bytes_max);
+
+  bytes_soma = 0;
+  bytes_max = 0;
+  quadros_enviados = 0;
+  quadros_total = 0;
+}
@@ -0,0 +1,16 @@
+#ifndef ESPELHO_H
+#define ESPELHO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ssd1306.h"
+
+#define ESPELHO_KEYFRAME_QUADROS 50 // Quadro completo a cada 50 quadros (~5 s a 10 Hz)
+#define ESPELHO_LEDS 25             // LEDs da matriz 5x5
+
+void espelho_habilitar(bool habilitado);
+void espelho_matriz(const uint32_t *cores);
+void espelho_display(const ssd1306_t *ssd);
+void espelho_relatorio(void);
+
+#endif
@@ -0,0 +1,137 @@
+#include <stdio.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/structs/systick.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "filtro.h"
+
+static const char *nomes_estagios[FILTRO_NUM_ESTAGIOS] = {"mediana", "iir", "deadband"};
+
+// Lê o contador do SysTick (decrescente, 24 bits, incrementado a cada ciclo de clk_sys)
+static inline uint32_t ciclos_agora(void) {
+  return systick_hw->cvr;
+}
+
+// Ciclos decorridos entre duas leituras, considerando uma recarga do SysTick
+static inline uint32_t ciclos_decorridos(uint32_t inicio, uint32_t fim) {
+  if (fim <= inicio)
+    return inicio - fim;
+  return inicio + (systick_hw->rvr + 1) - fim;
+}
+
+static void filtro_contabiliza(filtro_t *f, uint8_t estagio, uint32_t ciclos) {
+  f->ciclos_soma[estagio] += ciclos;
+  if (ciclos > f->ciclos_max[estagio])
+    f->ciclos_max[estagio] = ciclos;
+}
+
+void filtro_init(filtro_t *f, const filtro_config_t *config) {
+  memset(f, 0, sizeof(*f));
+  f->config = *config;
+  if (f->config.mediana_n == 0)
+    f->config.mediana_n = 1;
+  if (f->config.mediana_n > FILTRO_MEDIANA_MAX)
+    f->config.mediana_n = FILTRO_MEDIANA_MAX;
+}
+
+// Mediana da janela deslizante, rejeita picos isolados
+static uint16_t filtro_mediana(filtro_t *f, uint16_t amostra) {
+  uint16_t ordenado[FILTRO_MEDIANA_MAX];
+
+  f->janela[f->janela_pos] = amostra;
+  f->janela_pos = (f->janela_pos + 1) % f->config.mediana_n;
+  if (f->janela_qtd < f->config.mediana_n)
+    f->janela_qtd++;
+
+  // Ordenação por inserção, barata para janelas pequenas
+  for (uint8_t i = 0; i < f->janela_qtd; ++i) {
+    uint16_t valor = f->janela[i];
+    int8_t j = i - 1;
+    while (j >= 0 && ordenado[j] > valor) {
+      ordenado[j + 1] = ordenado[j];
+      j--;
+    }
+    ordenado[j + 1] = valor;
+  }
+  return ordenado[f->janela_qtd / 2];
+}
+
+// Passa-baixa de primeira ordem em ponto fixo, sem multiplicação nem divisão
+static uint16_t filtro_iir(filtro_t *f, uint16_t amostra) {
+  int32_t entrada = (int32_t)amostra << FILTRO_IIR_FRAC;
+
+  if (!f->iir_iniciado) {
+    f->iir_estado = entrada;
+    f->iir_iniciado = true;
+  } else {
+    f->iir_estado += (entrada - f->iir_estado) >> f->config.iir_shift;
+  }
+  return (f->iir_estado + (1 << (FILTRO_IIR_FRAC - 1))) >> FILTRO_IIR_FRAC;
+}
+
+// Só atualiza a saída quando a variação ultrapassa a zona morta
+static uint16_t filtro_deadband(filtro_t *f, uint16_t amostra) {
+  int32_t diferenca = (int32_t)amostra - f->saida;
+
+  if (!f->deadband_iniciado || diferenca > f->config.deadband || -diferenca > f->config.deadband) {
+    f->saida = amostra;
+    f->deadband_iniciado = true;
+  }
+  return f->saida;
+}
+
+uint16_t filtro_processar(filtro_t *f, uint16_t amostra) {
+  uint32_t inicio, fim;
+
+  if (f->config.estagios & FILTRO_MEDIANA) {
+    inicio = ciclos_agora();
+    amostra = filtro_mediana(f, amostra);
+    fim = ciclos_agora();
+    filtro_contabiliza(f, 0, ciclos_decorridos(inicio, fim));
+  }
+  if (f->config.estagios & FILTRO_IIR) {
+    inicio = ciclos_agora();
+    amostra = filtro_iir(f, amostra);
+    fim = ciclos_agora();
+    filtro_contabiliza(f, 1, ciclos_decorridos(inicio, fim));
+  }
+  if (f->config.estagios & FILTRO_DEADBAND) {
+    inicio = ciclos_agora();
+    amostra = filtro_deadband(f, amostra);
+    fim = ciclos_agora();
+    filtro_contabiliza(f, 2, ciclos_decorridos(inicio, fim));
+  }
+  f->amostras++;
+  return amostra;
+}
+
+// Imprime o custo médio e máximo de cada estágio e zera as estatísticas.
+// Pode ser chamada de outra tarefa: a cópia e o reinício são feitos em seção crítica.
+void filtro_relatorio(filtro_t *f, const char *nome) {
+  uint32_t ciclos_soma[FILTRO_NUM_ESTAGIOS];
+  uint32_t ciclos_max[FILTRO_NUM_ESTAGIOS];
+
+  taskENTER_CRITICAL();
+  uint32_t amostras = f->amostras;
+  memcpy(ciclos_soma, f->ciclos_soma, sizeof(ciclos_soma));
+  memcpy(ciclos_max, f->ciclos_max, sizeof(ciclos_max));
+  memset(f->ciclos_soma, 0, sizeof(f->ciclos_soma));
+  memset(f->ciclos_max, 0, sizeof(f->ciclos_max));
+  f->amostras = 0;
+  taskEXIT_CRITICAL();
+
+  if (amostras == 0)
+    return;
+
+  uint32_t total = 0;
+  printf("[filtro %s] ciclos media/max ->", nome);
+  for (uint8_t i = 0; i < FILTRO_NUM_ESTAGIOS; ++i) {
+    if (!(f->config.estagios & (1u << i)))
+      continue;
+    uint32_t media = ciclos_soma[i] / amostras;
+    total += media;
+    printf(" %s: %lu/%lu", nomes_estagios[i], (unsigned long)media, (unsigned long)ciclos_max[i]);
+  }
+  printf(" | total medio: %lu ciclos/amostra\n", (unsigned long)total);
+}
@@ -0,0 +1,46 @@
+#ifndef FILTRO_H
+#define FILTRO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define FILTRO_MEDIANA_MAX 7    // Tamanho máximo da janela da mediana
+#define FILTRO_IIR_FRAC 8       // Bits fracionários do estado do IIR (ponto fixo Q8)
+
+// Estágios da cadeia de filtros, podem ser combinados com '|'
+#define FILTRO_MEDIANA  (1u << 0)
+#define FILTRO_IIR      (1u << 1)
+#define FILTRO_DEADBAND (1u << 2)
+#define FILTRO_NUM_ESTAGIOS 3
+
+typedef struct {
+  uint8_t estagios;   // Máscara com os estágios habilitados
+  uint8_t mediana_n;  // Janela da mediana (ímpar, até FILTRO_MEDIANA_MAX)
+  uint8_t iir_shift;  // Passa-baixa: y += (x - y) / 2^iir_shift
+  uint16_t deadband;  // Variação mínima (em contagens do ADC) para atualizar a saída
+} filtro_config_t;
+
+typedef struct {
+  filtro_config_t config;
+
+  uint16_t janela[FILTRO_MEDIANA_MAX];
+  uint8_t janela_pos;
+  uint8_t janela_qtd;
+
+  int32_t iir_estado;
+  bool iir_iniciado;
+
+  uint16_t saida;
+  bool deadband_iniciado;
+
+  // Custo de cada estágio em ciclos de clk_sys, medido pelo SysTick
+  uint32_t ciclos_soma[FILTRO_NUM_ESTAGIOS];
+  uint32_t ciclos_max[FILTRO_NUM_ESTAGIOS];
+  uint32_t amostras;
+} filtro_t;
+
+void filtro_init(filtro_t *f, const filtro_config_t *config);
+uint16_t filtro_processar(filtro_t *f, uint16_t amostra);
+void filtro_relatorio(filtro_t *f, const char *nome);
+
+#endif
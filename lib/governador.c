@@ -0,0 +1,149 @@
+#include <stdio.h>
+#include "pico/stdlib.h"
+#include "hardware/clocks.h"
+#include "hardware/structs/systick.h"
+#include "hardware/structs/scb.h"
+#include "hardware/regs/m0plus.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "governador.h"
+
+static governador_periferico_t perifericos[GOVERNADOR_MAX_PERIFERICOS];
+static uint8_t num_perifericos = 0;
+
+static uint32_t khz_atual = 0;
+static uint64_t inicio_modo_us = 0;
+
+// Estatísticas desde o último relatório
+static uint64_t tempo_normal_us = 0;
+static uint64_t tempo_alerta_us = 0;
+static uint32_t transicoes = 0;
+static uint32_t latencia_max_us = 0;
+static uint64_t latencia_soma_us = 0;
+static uint32_t ticks_perdidos = 0;
+
+#define TICK_US (1000000 / configTICK_RATE_HZ)
+
+// Reprograma o SysTick para o novo clk_sys preservando a fase do tick em andamento.
+// 'ate_tick_us' é o tempo que faltava para o próximo tick no início da troca e
+// 'decorrido_us' o tempo gasto na seção crítica. Retorna quantos ticks foram perdidos.
+static uint32_t governador_ajustar_systick(uint32_t clk_hz, int64_t ate_tick_us, int64_t decorrido_us) {
+  int64_t restante_us = ate_tick_us - decorrido_us;
+  uint32_t perdidos = 0;
+
+  if (restante_us > 0) {
+    // Nenhuma fronteira de tick passou: descarta um tick que o SysTick possa ter
+    // sinalizado enquanto contava com o clock provisório da troca
+    scb_hw->icsr = M0PLUS_ICSR_PENDSTCLR_BITS;
+  } else {
+    // A primeira fronteira que passou fica pendente e é atendida ao sair da seção
+    // crítica; as demais foram perdidas
+    perdidos = -restante_us / TICK_US;
+    restante_us = TICK_US - (-restante_us % TICK_US);
+    scb_hw->icsr = M0PLUS_ICSR_PENDSTSET_BITS;
+  }
+
+  // Uma escrita no CVR sempre o zera, então a contagem restante é carregada pelo RVR
+  // na próxima recarga e o período completo é restaurado logo depois
+  uint32_t restante_ciclos = (uint64_t)restante_us * clk_hz / 1000000;
+  if (restante_ciclos < 2)
+    restante_ciclos = 2;
+  systick_hw->rvr = restante_ciclos - 1;
+  systick_hw->cvr = 0;
+  while (systick_hw->cvr == 0);
+  systick_hw->rvr = clk_hz / configTICK_RATE_HZ - 1;
+
+  return perdidos;
+}
+
+void governador_registrar(const governador_periferico_t *periferico) {
+  taskENTER_CRITICAL();
+  if (num_perifericos < GOVERNADOR_MAX_PERIFERICOS)
+    perifericos[num_perifericos++] = *periferico;
+  taskEXIT_CRITICAL();
+}
+
+static void governador_contabiliza_tempo(uint64_t agora) {
+  if (khz_atual == GOVERNADOR_KHZ_NORMAL)
+    tempo_normal_us += agora - inicio_modo_us;
+  else if (khz_atual == GOVERNADOR_KHZ_ALERTA)
+    tempo_alerta_us += agora - inicio_modo_us;
+  inicio_modo_us = agora;
+}
+
+// Ajusta clk_sys conforme o modo e recalcula tudo que depende dele.
+// Deve ser chamada por quem não está com uma transferência I2C em andamento.
+void governador_set_alerta(bool alerta) {
+  uint32_t khz = alerta ? GOVERNADOR_KHZ_ALERTA : GOVERNADOR_KHZ_NORMAL;
+  if (khz == khz_atual)
+    return;
+
+  uint64_t inicio = time_us_64();
+
+  taskENTER_CRITICAL();
+  // Fase do tick em andamento: tempo até o próximo tick com o clk_sys atual
+  int64_t ate_tick_us = (int64_t)systick_hw->cvr * 1000000 / clock_get_hz(clk_sys);
+  uint64_t inicio_troca = time_us_64();
+
+  for (uint8_t i = 0; i < num_perifericos; ++i) {
+    if (perifericos[i].preparar)
+      perifericos[i].preparar();
+  }
+
+  if (!set_sys_clock_khz(khz, false)) {
+    taskEXIT_CRITICAL();
+    return;
+  }
+  uint32_t clk_hz = clock_get_hz(clk_sys);
+
+  for (uint8_t i = 0; i < num_perifericos; ++i)
+    perifericos[i].ajustar(clk_hz);
+
+  // O tick do FreeRTOS vem do SysTick, que conta ciclos de clk_sys
+  uint32_t perdidos = governador_ajustar_systick(clk_hz, ate_tick_us, time_us_64() - inicio_troca);
+  taskEXIT_CRITICAL();
+
+  // Repõe os ticks perdidos para que o tempo do FreeRTOS continue alinhado com time_us
+  if (perdidos) {
+    xTaskCatchUpTicks(perdidos);
+    ticks_perdidos += perdidos;
+  }
+
+  uint64_t fim = time_us_64();
+  if (khz_atual != 0) {
+    uint32_t latencia = fim - inicio;
+    if (latencia > latencia_max_us)
+      latencia_max_us = latencia;
+    latencia_soma_us += latencia;
+    transicoes++;
+    governador_contabiliza_tempo(inicio);
+  }
+  khz_atual = khz;
+  inicio_modo_us = fim;
+}
+
+// Imprime tempo em cada modo, latência das transições e a energia economizada
+// em relação a manter clk_sys sempre em GOVERNADOR_KHZ_ALERTA
+void governador_relatorio(void) {
+  governador_contabiliza_tempo(time_us_64());
+
+  uint32_t latencia_media = transicoes ? latencia_soma_us / transicoes : 0;
+  uint32_t economia_ua = ((GOVERNADOR_KHZ_ALERTA - GOVERNADOR_KHZ_NORMAL) / 1000) * GOVERNADOR_CONSUMO_UA_POR_MHZ;
+  uint32_t consumo_alerta_ua = GOVERNADOR_CONSUMO_BASE_UA + (GOVERNADOR_KHZ_ALERTA / 1000) * GOVERNADOR_CONSUMO_UA_POR_MHZ;
+  // uA * mV * us = 1e-15 J, convertido para uJ
+  uint64_t economia_uj = (uint64_t)economia_ua * GOVERNADOR_TENSAO_MV * tempo_normal_us / 1000000000ull;
+  uint64_t total_us = tempo_normal_us + tempo_alerta_us;
+  uint32_t economia_pct = total_us ? (economia_ua * tempo_normal_us * 100) / (consumo_alerta_ua * total_us) : 0;
+
+  printf("[governador] clk_sys: %lu kHz | normal/alerta: %lu/%lu ms | transicoes: %lu, latencia media/max: %lu/%lu us, ticks perdidos (repostos): %lu | economia estimada: %lu uJ (%lu%%)\n",
+         (unsigned long)khz_atual, (unsigned long)(tempo_normal_us / 1000), (unsigned long)(tempo_alerta_us / 1000),
+         (unsigned long)transicoes, (unsigned long)latencia_media, (unsigned long)latencia_max_us, (unsigned long)ticks_perdidos,
+         (unsigned long)economia_uj, (unsigned long)economia_pct);
+
+  tempo_normal_us = 0;
+  tempo_alerta_us = 0;
+  transicoes = 0;
+  latencia_max_us = 0;
+  latencia_soma_us = 0;
+  ticks_perdidos = 0;
+}
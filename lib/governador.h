@@ -0,0 +1,26 @@
+#ifndef GOVERNADOR_H
+#define GOVERNADOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define GOVERNADOR_KHZ_NORMAL 48000   // clk_sys no modo Normal
+#define GOVERNADOR_KHZ_ALERTA 125000  // clk_sys no modo Alerta
+#define GOVERNADOR_MAX_PERIFERICOS 4
+
+// Modelo aproximado de consumo do RP2040 (corrente base + parcela proporcional a clk_sys)
+#define GOVERNADOR_CONSUMO_BASE_UA 7500
+#define GOVERNADOR_CONSUMO_UA_POR_MHZ 140
+#define GOVERNADOR_TENSAO_MV 3300
+
+// Periférico cuja temporização depende de clk_sys
+typedef struct {
+  void (*preparar)(void);          // Opcional: chamado antes da troca (ex.: esperar fim de transmissão)
+  void (*ajustar)(uint32_t clk_hz); // Recalcula divisores para o novo clk_sys
+} governador_periferico_t;
+
+void governador_registrar(const governador_periferico_t *periferico);
+void governador_set_alerta(bool alerta);
+void governador_relatorio(void);
+
+#endif
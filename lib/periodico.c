@@ -0,0 +1,97 @@
+#include <stdio.h>
+#include "pico/stdlib.h"
+#include "periodico.h"
+
+#define TICK_US (1000000u / configTICK_RATE_HZ)
+
+static volatile uint32_t tick_us = 0; // Instante do último incremento do tick do FreeRTOS
+
+// Chamado pelo FreeRTOS a cada tick (configUSE_TICK_HOOK)
+void vApplicationTickHook(void) {
+  tick_us = time_us_32();
+}
+
+// Atraso entre o instante em que o tick 'prazo' ocorreu e agora
+static uint32_t periodico_atraso_us(TickType_t prazo) {
+  taskENTER_CRITICAL();
+  TickType_t tick = xTaskGetTickCount();
+  uint32_t instante_tick = tick_us;
+  uint32_t agora = time_us_32();
+  taskEXIT_CRITICAL();
+
+  return (agora - instante_tick) + (tick - prazo) * TICK_US;
+}
+
+void periodico_init(periodico_t *p, uint32_t freq_hz) {
+  p->ultimo_despertar = xTaskGetTickCount();
+  p->resto_us = 0;
+  p->jitter_max_us = 0;
+  p->jitter_soma_us = 0;
+  p->periodos = 0;
+  p->perdidos = 0;
+  periodico_set_freq(p, freq_hz);
+}
+
+// Altera a frequência sem perder a referência de tempo absoluta
+void periodico_set_freq(periodico_t *p, uint32_t freq_hz) {
+  if (freq_hz < PERIODICO_FREQ_MIN)
+    freq_hz = PERIODICO_FREQ_MIN;
+  if (freq_hz > PERIODICO_FREQ_MAX)
+    freq_hz = PERIODICO_FREQ_MAX;
+
+  p->freq_hz = freq_hz;
+  p->periodo_us = 1000000u / freq_hz;
+}
+
+// Jitter: atraso da ativação em relação ao seu prazo absoluto. Medir contra o prazo, e não
+// contra o período nominal, evita contar como jitter a alternância de 1 e 2 ticks usada
+// em taxas que não dividem o tick.
+static void periodico_contabiliza(periodico_t *p, TickType_t prazo, bool no_prazo) {
+  uint32_t atraso = periodico_atraso_us(prazo);
+
+  p->periodos++;
+  if (!no_prazo)
+    p->perdidos++;
+  if (atraso > p->jitter_max_us)
+    p->jitter_max_us = atraso;
+  p->jitter_soma_us += atraso;
+}
+
+// Bloqueia até o próximo prazo absoluto. Retorna false se o prazo já havia passado.
+bool periodico_aguardar(periodico_t *p) {
+  p->resto_us += p->periodo_us;
+  TickType_t incremento = p->resto_us / TICK_US;
+  p->resto_us %= TICK_US;
+
+  bool no_prazo = xTaskDelayUntil(&p->ultimo_despertar, incremento) == pdTRUE;
+  periodico_contabiliza(p, p->ultimo_despertar, no_prazo);
+  return no_prazo;
+}
+
+// Registra uma ativação feita por outro mecanismo (ex.: timer de auto-reload) com prazo absoluto 'prazo'.
+// O prazo é considerado perdido quando o atraso chega a um período.
+void periodico_registrar(periodico_t *p, TickType_t prazo) {
+  periodico_contabiliza(p, prazo, periodico_atraso_us(prazo) < p->periodo_us);
+}
+
+// Imprime jitter médio/máximo e prazos perdidos, depois zera as estatísticas.
+// A cópia e o reinício são feitos em seção crítica porque quem registra as ativações
+// (ex.: a tarefa de timers, de prioridade maior) pode interromper quem imprime.
+void periodico_relatorio(periodico_t *p, const char *nome) {
+  taskENTER_CRITICAL();
+  uint32_t freq_hz = p->freq_hz;
+  uint32_t jitter_max_us = p->jitter_max_us;
+  uint64_t jitter_soma_us = p->jitter_soma_us;
+  uint32_t periodos = p->periodos;
+  uint32_t perdidos = p->perdidos;
+  p->jitter_max_us = 0;
+  p->jitter_soma_us = 0;
+  p->periodos = 0;
+  p->perdidos = 0;
+  taskEXIT_CRITICAL();
+
+  uint32_t media = periodos ? jitter_soma_us / periodos : 0;
+  printf("[periodo %s] %lu Hz | atraso sobre o prazo media/max: %lu/%lu us | prazos perdidos: %lu de %lu\n",
+         nome, (unsigned long)freq_hz, (unsigned long)media, (unsigned long)jitter_max_us,
+         (unsigned long)perdidos, (unsigned long)periodos);
+}
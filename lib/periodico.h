@@ -0,0 +1,31 @@
+#ifndef PERIODICO_H
+#define PERIODICO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "FreeRTOS.h"
+#include "task.h"
+
+#define PERIODICO_FREQ_MIN 1                  // 1 Hz
+#define PERIODICO_FREQ_MAX configTICK_RATE_HZ // Um período por tick (1 kHz)
+
+typedef struct {
+  TickType_t ultimo_despertar; // Prazo absoluto da última ativação, em ticks
+  uint32_t freq_hz;
+  uint32_t periodo_us;
+  uint32_t resto_us;           // Fração de tick acumulada, evita deriva quando o período não é múltiplo do tick
+
+  // Estatísticas desde o último relatório
+  uint32_t jitter_max_us;      // Maior atraso da ativação em relação ao prazo
+  uint64_t jitter_soma_us;
+  uint32_t periodos;
+  uint32_t perdidos;
+} periodico_t;
+
+void periodico_init(periodico_t *p, uint32_t freq_hz);
+void periodico_set_freq(periodico_t *p, uint32_t freq_hz);
+bool periodico_aguardar(periodico_t *p);
+void periodico_registrar(periodico_t *p, TickType_t prazo);
+void periodico_relatorio(periodico_t *p, const char *nome);
+
+#endif
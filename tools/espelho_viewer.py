@@ -0,0 +1,165 @@
+#!/usr/bin/env python3
+"""Visualizador do espelho do display OLED e da matriz de LEDs.
+
+Lê as linhas $F* enviadas pela serial USB (lib/espelho.c), reconstrói o
+framebuffer e desenha a tela no terminal. As demais linhas (relatórios)
+são mostradas abaixo da tela.
+
+Uso:
+    python3 espelho_viewer.py /dev/ttyACM0       # requer pyserial
+    python3 espelho_viewer.py - < captura.txt    # lê de uma captura
+"""
+
+import sys
+
+LARGURA = 128
+PAGINAS = 8
+LEDS = 25
+
+
+def decodifica_rle(texto):
+    dados = bytes.fromhex(texto)
+    saida = bytearray()
+    for i in range(0, len(dados), 2):
+        saida.extend([dados[i + 1]] * dados[i])
+    return saida
+
+
+class Espelho:
+    def __init__(self):
+        self.quadro = [bytearray(LARGURA) for _ in range(PAGINAS)]
+        self.matriz = [(0, 0, 0)] * LEDS
+        self.sincronizado = False  # Deltas só valem sobre um quadro-chave completo
+        self.seq = None  # Sequência esperada no próximo quadro
+        self.paginas_chave = set()
+        self.perdas = 0
+        self.bytes_quadro = 0
+        self.ultimas_linhas = []
+
+    def processa(self, linha):
+        """Processa uma linha, retorna True quando um quadro termina."""
+        if not linha.startswith("$F"):
+            if linha:
+                self.ultimas_linhas = (self.ultimas_linhas + [linha])[-4:]
+            return False
+
+        self.bytes_quadro += len(linha) + 1
+        try:
+            return self.processa_quadro(linha.split(","))
+        except (ValueError, IndexError):
+            # Linha truncada ou corrompida na serial: o quadro atual ficou incompleto
+            self.dessincroniza()
+            return False
+
+    def dessincroniza(self):
+        """Descarta o estado até o próximo quadro-chave."""
+        if self.sincronizado:
+            self.perdas += 1
+        self.sincronizado = False
+        self.seq = None
+        self.paginas_chave = set()
+
+    def processa_quadro(self, campos):
+        tipo = campos[0][2:]
+
+        if tipo in ("K", "D"):
+            if len(campos) != 4:
+                raise ValueError(campos)
+            seq, pagina = int(campos[1]), int(campos[2])
+            dados = decodifica_rle(campos[3])
+            if len(dados) != LARGURA or not 0 <= pagina < PAGINAS:
+                raise ValueError(campos)
+
+            if tipo == "K":
+                if seq != self.seq:
+                    # Início de um quadro-chave fora da sequência: recomeça a partir dele
+                    self.sincronizado = False
+                    self.seq = seq
+                    self.paginas_chave = set()
+                self.quadro[pagina] = dados
+                self.paginas_chave.add(pagina)
+            elif seq != self.seq:
+                # Um quadro se perdeu, o XOR seria aplicado sobre a base errada
+                self.dessincroniza()
+            elif self.sincronizado:
+                atual = self.quadro[pagina]
+                self.quadro[pagina] = bytearray(a ^ d for a, d in zip(atual, dados))
+        elif tipo == "M":
+            rgb = bytes.fromhex(campos[1])
+            if len(campos) != 2 or len(rgb) != LEDS * 3:
+                raise ValueError(campos)
+            self.matriz = [tuple(rgb[i:i + 3]) for i in range(0, len(rgb), 3)]
+        elif tipo == "E":
+            if len(campos) != 2:
+                raise ValueError(campos)
+            seq = int(campos[1])
+            if seq != self.seq:
+                self.dessincroniza()
+                return False
+            if len(self.paginas_chave) == PAGINAS:
+                self.sincronizado = True
+            self.paginas_chave = set()
+            self.seq = (seq + 1) & 0xFFFFFFFF
+            return self.sincronizado
+        else:
+            raise ValueError(campos)
+        return False
+
+    def pixel(self, x, y):
+        return (self.quadro[y // 8][x] >> (y % 8)) & 1
+
+    def desenha(self):
+        saida = ["\x1b[H"]
+        # Cada caractere representa dois pixels na vertical
+        for y in range(0, PAGINAS * 8, 2):
+            for x in range(LARGURA):
+                cima, baixo = self.pixel(x, y), self.pixel(x, y + 1)
+                saida.append(" ▀▄█"[cima | (baixo << 1)])
+            saida.append("\n")
+
+        saida.append("\n")
+        for linha in range(5):
+            for coluna in range(5):
+                # A matriz usa brilho baixo (20/255), realçado para ficar visível
+                r, g, b = (min(255, c * 12) for c in self.matriz[linha * 5 + coluna])
+                saida.append(f"\x1b[38;2;{r};{g};{b}m██\x1b[0m")
+            saida.append("\n")
+
+        saida.append(f"\n{self.bytes_quadro} bytes no ultimo quadro, {self.perdas} perdas de sincronismo\x1b[K\n")
+        for texto in self.ultimas_linhas:
+            saida.append(texto + "\x1b[K\n")
+        sys.stdout.write("".join(saida))
+        sys.stdout.flush()
+        self.bytes_quadro = 0
+
+
+def main():
+    if len(sys.argv) != 2:
+        print(__doc__)
+        return 1
+
+    if sys.argv[1] == "-":
+        linhas = (linha for linha in sys.stdin)
+    else:
+        import serial
+
+        porta = serial.Serial(sys.argv[1], 115200, timeout=1)
+        porta.write(b"espelho 1\n")  # Habilita o espelho e força um quadro-chave
+        linhas = (linha.decode("ascii", "replace") for linha in iter(porta.readline, None))
+
+    espelho = Espelho()
+    sys.stdout.write("\x1b[2J")
+    try:
+        for linha in linhas:
+            if espelho.processa(linha.strip()):
+                espelho.desenha()
+    except KeyboardInterrupt:
+        pass
+    finally:
+        if sys.argv[1] != "-":
+            porta.write(b"espelho 0\n")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())